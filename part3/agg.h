@@ -0,0 +1,114 @@
+#ifndef AGG_H
+#define AGG_H
+
+#include <mutex>
+#include <vector>
+#include "page.h"
+#include "db.h"
+#include "query.h"
+#include "bulkLoad.h"
+
+// most grouping attributes and aggregates of one aggregation
+const int MAXGROUPATTRS = 8;
+const int MAXAGGS = 16;
+
+// number of partition files an aggregation spills its groups into
+const int AGGSPILLPARTS = 16;
+
+enum AggFunc { COUNT, SUM, MIN, MAX, AVG };
+
+// one aggregate: func over attr. attr is not used by COUNT and must be
+// an INTEGER or FLOAT attribute for the others
+struct AggDesc
+{
+  AggFunc  func;
+  AttrDesc attr;
+};
+
+// Hash aggregation (GROUP BY) over the records of a heap file.
+//
+// The input is scanned in parallel and every thread pre-aggregates into
+// its own hash table. Groups and their running aggregates live in the
+// thread's arena, so adding a group costs no allocation of its own.
+// After the scan the thread tables are merged, split by hash value so
+// that each thread merges a disjoint set of groups.
+//
+// A thread whose table outgrows its share of the memory grant writes
+// its partial groups to AGGSPILLPARTS temporary files by hash value and
+// starts over with an empty table. Spill pages are allocated and
+// written through the buffer pool: each partition collects a page worth
+// of groups, then copies them into a page from allocPage and unpins it
+// dirty, so spilling pins one frame at a time and its pages are written
+// and evicted like any others. If any thread spilled, all partial
+// groups go to the partition files and each partition is then merged
+// on its own. A partition that is still larger than the grant is merged
+// in memory anyway.
+//
+// Every group produces one record in the result file: the grouping
+// attributes packed one after the other (strings padded with NULs),
+// then, at getAggOffset(i), the value of aggregate i as a double.
+
+class HashAggregate {
+ public:
+  HashAggregate(DB & db, const int numThreads, const long memGrant);
+
+  // aggregates input into a new file resultName, which is closed again
+  // when done. groupCnt may be 0 for a single group over all records;
+  // its record is written even if input is empty, with COUNT 0 and the
+  // other aggregates NaN.
+  // Returns BADSCANPARM for bad attribute or aggregate counts,
+  // ATTRTYPEMISMATCH for a non-numeric aggregate attribute, BADRECPTR
+  // for a record too short for the attributes and TMP_RES_EXISTS if the
+  // result or a spill file exists already
+  const Status aggregate(File* input,
+			 const AttrDesc groupAttrs[], const int groupCnt,
+			 const AggDesc aggs[], const int aggCnt,
+			 const string & resultName, int & resultCnt);
+
+  int getAggOffset(const int aggNo) const // offset of an aggregate in results
+    { return stateOff + aggNo * sizeof(double); }
+  bool getSpilled() const { return spilled; }
+
+ private:
+  friend class AggTable;
+  friend class AggWorker;
+
+  void makeKey(const char* rec, char* key) const;
+  void initGroup(char* group) const;
+  void updateGroup(char* group, const char* rec) const;
+  void mergeGroup(char* group, const char* other) const;
+
+  const Status startSpill();
+  const Status spillTable(class AggTable & table);
+  const Status spillPage(const int part); // write a partition's groups
+  const Status mergeTables(vector<class AggTable*> & tables);
+  const Status aggregatePart(File* part);
+  const Status emit(const char* buf, const int len); // flush result records
+
+  DB &	   db;
+  int	   numThreads;
+  long	   memGrant;          // bytes all group tables together may use
+  AttrDesc groupAttrs[MAXGROUPATTRS];
+  int	   groupCnt;
+  AggDesc  aggs[MAXAGGS];
+  int	   aggCnt;
+  int	   minRecLen;         // shortest record holding all attributes
+  int	   keyLen;            // bytes of the packed grouping attributes
+  int	   stateOff;          // offset of the aggregates in a group
+  int	   groupLen;          // bytes of a group: key and running aggregates
+  int	   pageGroups;        // groups that fit on a spill page
+
+  string   resultName;
+  bool	   spilled;
+  mutex	   spillLock;         // protects spilled and the spill files
+  File*	   spillFiles[AGGSPILLPARTS];
+  char*	   spillBufs[AGGSPILLPARTS]; // groups not yet on a spill page
+  int	   spillCnts[AGGSPILLPARTS]; // number of groups in spillBufs
+  mutex	   partLocks[AGGSPILLPARTS]; // one per spill partition
+
+  BulkLoader* out;            // writes the result file
+  mutex	   outLock;           // protects out and outCnt
+  int	   outCnt;            // records written to the result
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <vector>
+using namespace std;
+
+// size of the blocks an arena carves its allocations from
+const int ARENABLOCK = 64 * 1024;
+
+// A simple region allocator for query operators. Memory is handed out
+// from large blocks and is only returned all at once, when the arena
+// is reset or destroyed, so per-record or per-group allocations cost
+// a pointer bump. An arena is used by one thread at a time.
+
+class Arena {
+ public:
+  Arena()
+    {
+      cur = NULL;
+      left = 0;
+      bytes = 0;
+    }
+
+  ~Arena()
+    {
+      reset();
+    }
+
+  // returns size bytes aligned to 8, or NULL if out of memory
+  char* alloc(const int size)
+    {
+      int need = (size + 7) & ~7;
+      if (need > left) {
+        int blockSize = need > ARENABLOCK ? need : ARENABLOCK;
+        char* block = (char*) malloc(blockSize);
+        if (!block)
+          return NULL;
+        blocks.push_back(block);
+        cur = block;
+        left = blockSize;
+        bytes += blockSize;
+      }
+      char* p = cur;
+      cur += need;
+      left -= need;
+      return p;
+    }
+
+  // releases everything allocated from the arena
+  void reset()
+    {
+      for (int i = 0; i < (int) blocks.size(); i++)
+        free(blocks[i]);
+      blocks.clear();
+      cur = NULL;
+      left = 0;
+      bytes = 0;
+    }
+
+  long getBytes() const { return bytes; } // memory held by the arena
+
+ private:
+  vector<char*> blocks;  // all blocks, freed by reset()
+  char*	cur;             // next free byte of the current block
+  int	left;            // bytes left in the current block
+  long	bytes;           // total size of all blocks
+};
+
+#endif
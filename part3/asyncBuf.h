@@ -0,0 +1,123 @@
+#ifndef ASYNCBUF_H
+#define ASYNCBUF_H
+
+#include <coroutine>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "page.h"
+#include "buf.h"
+
+// default number of threads an event loop reads missing pages with
+const int ASYNCIOTHREADS = 8;
+
+// Coroutine access to the buffer pool. A Task is a coroutine that
+// returns a Status; it can wait for pages with
+//
+//   Status status = co_await bufMgr->readPageAsync(file, pageNo, page);
+//
+// which has the meaning of readPage. Tasks are run by an EventLoop on
+// the thread that calls EventLoop::run(). A page that is in the buffer
+// pool is pinned right away without suspending the task; on a miss the
+// task is suspended and the page is read by one of the loop's I/O
+// threads, so that many tasks can wait for pages on few threads.
+//
+// Each I/O thread reads one page at a time with the blocking readPage,
+// so at most as many misses as the loop has I/O threads are read at
+// once, however many tasks wait; further misses queue. The number of
+// I/O threads, not of tasks, sets how much of the disk's parallelism
+// a loop uses (benchbuf async compares this with a thread per
+// request).
+//
+// The pages read for a loop's tasks are pinned until the tasks run,
+// up to twice the number of I/O threads, so the pool needs more frames
+// than that. A task must not keep pages pinned for long across
+// co_await either.
+
+class Task {
+ public:
+  struct promise_type
+  {
+    Status status = OK;
+
+    Task get_return_object()
+    {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_value(const Status s) { status = s; }
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  Task(Task && other) : handle(other.handle) { other.handle = nullptr; }
+  ~Task() { if (handle) handle.destroy(); }
+
+ private:
+  friend class EventLoop;
+  explicit Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+
+class EventLoop {
+ public:
+  EventLoop(const int ioThreads = ASYNCIOTHREADS);
+  ~EventLoop();                   // stops the I/O threads
+
+  void spawn(Task task);          // the task first runs in run()
+
+  // runs the spawned tasks until all of them are done. Returns OK or
+  // the status of the first task that did not return OK
+  const Status run();
+
+  int getMisses() const { return misses; } // reads done by I/O threads
+
+ private:
+  friend class PageRead;
+
+  void submit(class PageRead* read);  // queue a read for the I/O threads
+  void ioWork();                      // body of an I/O thread
+
+  std::deque<std::coroutine_handle<Task::promise_type> > ready; // loop only
+  int	active;                  // tasks spawned and not done
+
+  mutex	ioLock;                  // protects the fields below
+  condition_variable ioWake;     // signals reads and stopping
+  condition_variable loopWake;   // signals completed reads
+  std::deque<class PageRead*> reads;     // waiting for an I/O thread
+  std::deque<class PageRead*> completed; // done, task not resumed yet
+  bool	stopping;
+  int	misses;
+
+  int	numIoThreads;
+  vector<thread> ioThreads;
+};
+
+
+// The awaitable returned by BufMgr::readPageAsync.
+class PageRead {
+ public:
+  PageRead(BufMgr* mgr, File* filePtr, const int pageNum, Page*& pagePtr)
+    : bufMgr(mgr), file(filePtr), pageNo(pageNum), page(pagePtr),
+      status(OK) {}
+
+  bool await_ready();
+  bool await_suspend(std::coroutine_handle<Task::promise_type> task);
+  Status await_resume() const { return status; }
+
+ private:
+  friend class EventLoop;
+
+  BufMgr* bufMgr;
+  File*	file;
+  int	pageNo;
+  Page*& page;
+  Status status;
+  std::coroutine_handle<Task::promise_type> task; // suspended on this read
+};
+
+#endif
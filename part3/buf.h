@@ -1,7 +1,11 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include "db.h"
+#include "compTier.h"
 // define if debug output wanted
 //#define DEBUGBUF
 
@@ -43,6 +47,7 @@ public:
 
 
 class BufMgr;  //forward declaration of BufMgr class 
+class PageRead; // awaitable page read, see asyncBuf.h
 
 // class for maintaining information about buffer pool frames
 class BufDesc {
@@ -55,6 +60,12 @@ private:
   bool 	dirty;	  // true if dirty;  false otherwise
   bool 	valid;   // true if page is valid
   bool  refbit;	 // has this buffer frame been reference recently
+  bool  loading;  // page is being read in by the thread that pinned it
+  Status ioStatus; // result of that read, for threads waiting on it
+  bool  writing;  // a copy is being written by the checkpointer; the
+                  // frame must not be reused until it is on disk
+  int   prevFrame; // previous frame holding a page of the same file
+  int   nextFrame; // next frame holding a page of the same file
 
   void Clear() {  // initialize buffer frame for a new user
     	pinCnt = 0;
@@ -62,6 +73,9 @@ private:
 	pageNo = -1;
     	dirty = false;
 	valid = false;
+	loading = false;
+	ioStatus = OK;
+	writing = false;
   };
 
   void Set(File* filePtr, int pageNum) { 
@@ -71,6 +85,9 @@ private:
       dirty = false;
       valid = true;
       refbit = true;
+      loading = false;
+      ioStatus = OK;
+      writing = false;
   }
 
   BufDesc() {
@@ -97,6 +114,9 @@ struct BufStats
 };
 
 
+// first word of a list of resident pages written by BufMgr::saveResident
+const int RESIDENTMAGIC = 0x52455331;
+
 class BufMgr 
 {
 private:
@@ -105,6 +125,13 @@ private:
   BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
   BufStats	 bufStats;	// buffer pool statistics
+  CompTier*	 compTier;	// compressed tier for clean victims, or NULL
+
+  // The latch protects all of the above. It is released while a page
+  // is read from disk; the frame stays pinned and marked loading, and
+  // threads that want the same page wait on ioDone.
+  mutex		 latch;
+  condition_variable ioDone;
 
   const Status allocBuf(int & frame);   // allocate a free frame.  
   const void releaseBuf(int frame); // return unused frame to end of list
@@ -113,19 +140,115 @@ private:
 	clockHand = (clockHand + 1) % numBufs;
   }
 
+  // per-file frame lists, so that flushFile only visits the frames
+  // of the file being flushed
+  void linkFrame(const int frame);   // add frame to its file's list
+  void unlinkFrame(const int frame); // remove frame from its file's list
+
+  // wait until a pinned frame is no longer loading; returns the status
+  // of the read. The caller holds the latch through guard
+  const Status waitLoaded(unique_lock<mutex> & guard, const int frame);
+  // end the read of a loading frame; on failure the page is dropped
+  void finishLoad(const int frame, const Status status);
+  // drop one pin of a frame whose read may have failed
+  void dropPin(const int frame);
+
+  // Checkpoints. ckptLock serializes them; the other fields are
+  // protected by the latch. flushFile waits while the file it flushes
+  // is on ckptFiles, so the files a checkpoint collected stay open
+  // until it is done with them.
+  mutex		 ckptLock;
+  int		 checkpointNo;	// number of the last checkpoint started
+  vector<const File*> ckptFiles; // files the running checkpoint has
+				// still to write
+  Status	 ckptStatus;	// first error of the background checkpointer
+  thread*	 ckptThread;	// background checkpointer, or NULL
+  bool		 ckptStop;	// tells the checkpointer to stop
+  condition_variable ckptWake;
+
+  const Status checkpointFile(File* file, const vector<int> & pageNos,
+			      const int ckptNo, Page* copies,
+			      const long bytesPerSec, bool complete);
+  void checkpointLoop(const int intervalMs, const long bytesPerSec);
+
+  string	 residentList;	// where the resident pages are saved, or ""
+
+  // Backups. backupLock serializes them; the other fields are
+  // protected by the latch. allocPage and disposePage record the pages
+  // of backupFile they change and wait while backupFrozen is set, as
+  // bulk loads do in File::setNumPages; flushFile waits while
+  // backupFile is the file it flushes, and unPinPage wakes a backup
+  // waiting for a page of it.
+  mutex		 backupLock;
+  const File*	 backupFile;	// file being backed up, or NULL
+  bool		 backupFrozen;	// pages of backupFile may not be
+				// allocated or disposed
+  vector<int>	 backupChanges;	// pages of backupFile allocated or
+				// disposed since they were copied
+
+  const Status backupRun(File* file, const int fd, const int firstPage,
+			 const int cnt, Page* copies, Page* disk,
+			 vector<int> & pinned);
+
+  // pin a page that is in the pool and not being read; false otherwise
+  friend class PageRead;
+  bool tryReadPage(File* file, const int PageNo, Page*& page);
+
 
 public:
   Page*	         bufPool;   // actual buffer pool
 
-  BufMgr(const int bufs);
+  BufMgr(const int bufs, const long tierBytes = 0); // tierBytes > 0 adds
+                                                    // a compressed tier
   ~BufMgr();
 
   const Status readPage(File* file, const int PageNo, Page*& page);
+  const Status readPages(File* file, const int pageNos[], const int n,
+                         Page* pages[]); // read and pin a batch of pages
+  PageRead readPageAsync(File* file, const int PageNo, Page*& page);
+                        // co_await in a Task, see asyncBuf.h
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
   const Status allocPage(File* file, int& PageNo, Page*& page); 
                         // allocates a new, empty page 
   const Status flushFile(const File* file); // writing out all dirty pages of the file
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
+
+  // Writes all pages that are dirty when it starts, without evicting
+  // them; pinned ones are left for the next checkpoint. Records the
+  // checkpoint number in the header of every open file none of whose
+  // dirty pages was left. Writes are limited to bytesPerSec (0 for no
+  // limit) so foreground work keeps its share of the disk
+  const Status checkpoint(const long bytesPerSec = 0);
+  // runs checkpoint(bytesPerSec) every intervalMs in a background thread
+  void startCheckpointer(const int intervalMs, const long bytesPerSec = 0);
+  void stopCheckpointer();  // waits for a running checkpoint to end
+  const Status getCheckpointStatus(); // OK unless a background one failed
+  int getCheckpointNo();              // number of the last one started
+
+  // Warm restart. saveResident writes the file name and page number of
+  // every page in the pool to listName, hottest first by the clock.
+  // warmUp reads such a list and loads the listed pages of the given
+  // open files, at most as many as the pool holds, with numThreads
+  // threads reading sorted batches of pages; it may run while the pool
+  // already serves requests. A missing list loads nothing.
+  // setResidentList makes ~BufMgr and the background checkpointer save
+  // the list ("" to stop)
+  const Status saveResident(const string & listName);
+  const Status warmUp(const string & listName, File* const files[],
+                      const int fileCnt, const int numThreads,
+                      int & pagesRead);
+  void setResidentList(const string & listName);
+
+  // Online backup. Writes an image of file to imageName while the pool
+  // keeps serving. Pages are read with large reads through the file's
+  // own descriptor rather than through the pool, and resident pages
+  // are copied from their frames, so nothing is evicted and changes
+  // not yet written are included. Reads are limited to bytesPerSec (0
+  // for no limit). The image has the format of any other file: it can
+  // be opened, or renamed over the file while that is closed to
+  // restore it
+  const Status backup(File* file, const string & imageName,
+                      const long bytesPerSec = 0);
   void  printSelf();
 
   const BufStats & getBufStats() const // get buffer pool usage
@@ -136,6 +259,11 @@ public:
   {
 	bufStats.clear();
   }
+
+  const CompTier* getCompTier() const // NULL if there is no compressed tier
+  {
+	return compTier;
+  }
 };
 
 #endif
@@ -0,0 +1,57 @@
+#ifndef BULKLOAD_H
+#define BULKLOAD_H
+
+#include <iostream>
+#include "page.h"
+#include "db.h"
+
+// number of pages a bulk loader builds in memory before writing them
+const int LOADBATCH = 256;
+
+// A bulk loader appends records to a file without going through the
+// buffer pool. Pages are built in a private batch of LOADBATCH pages,
+// chained to each other through their nextPage links, and written to
+// the end of the file with one large sequential write per batch. The
+// file header is only updated by finish(), so a load that is never
+// finished leaves the file as it was.
+//
+// While a load is in progress nothing else may allocate pages in the
+// file.
+
+class BulkLoader {
+ public:
+  // lastPageNo is the current last page of the file's page chain, or -1
+  // if the loaded pages start a new chain. On finish() that page is
+  // linked to the first loaded page through the buffer pool.
+  BulkLoader(File* file, const int lastPageNo = -1);
+  ~BulkLoader();
+
+  // adds a record to the current page, starting a new page when it is
+  // full. Returns NOSPACE if the record does not fit on an empty page
+  const Status insertRecord(const Record & rec, RID& rid);
+
+  // loads records of recLen bytes each from in until end of stream;
+  // cnt returns the number of records loaded
+  const Status load(istream & in, const int recLen, int& cnt);
+
+  // writes out the last batch and updates the file header
+  const Status finish();
+
+  int getFirstPage() const { return firstPage; } // -1 if nothing loaded
+  int getPageCnt() const { return pageCnt; }
+
+ private:
+  const Status writeBatch();  // write the pages built so far
+  void noteRecord(const RID & rid, const Record & rec); // update zone maps
+
+  File*  file;        // file being loaded
+  Page*  batch;       // pages being built
+  int    batchCnt;    // pages of batch in use
+  int    batchStart;  // page number of batch[0]
+  int    firstPage;   // first loaded page
+  int    prevPage;    // page to link to the first loaded page
+  int    pageCnt;     // number of pages loaded
+  bool   finished;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef COMPTIER_H
+#define COMPTIER_H
+
+#include "db.h"
+
+// A second-tier page cache that sits between the buffer pool and the
+// disk. Clean pages evicted from the buffer pool are kept here in
+// compressed form until the tier's memory budget is used up, so that
+// pages which are re-read soon after eviction do not cost a disk read.
+// The tier is exclusive: a page found here is moved back into the
+// buffer pool and removed from the tier.
+
+// one compressed page
+struct compEntry
+{
+	File*	file;     // file the page belongs to
+	int	pageNo;   // page number within the file
+	int	len;      // length of the compressed image
+	char*	data;     // compressed page image
+	compEntry*	next;     // next entry in the hash chain
+	compEntry*	lruPrev;  // more recently inserted entry
+	compEntry*	lruNext;  // less recently inserted entry
+	compEntry*	filePrev; // previous entry of the same file
+	compEntry*	fileNext; // next entry of the same file
+};
+
+
+struct CompStats
+{
+  int hits;        // lookups satisfied by the tier
+  int misses;      // lookups that had to go to disk
+  int inserts;     // pages stored in the tier
+  int rejects;     // pages that did not compress well enough to keep
+  int evictions;   // pages dropped to stay within the memory budget
+
+  void clear()
+    {
+      hits = misses = inserts = rejects = evictions = 0;
+    }
+
+  CompStats()
+    {
+      clear();
+    }
+};
+
+
+class CompTier
+{
+private:
+    int HTSIZE;
+    compEntry**  ht;      // hash table on (file, pageNo)
+    compEntry*   lruHead; // most recently inserted entry
+    compEntry*   lruTail; // least recently inserted entry
+    long	 budget;  // memory budget in bytes
+    long	 used;    // bytes currently used by entries
+    CompStats	 stats;
+
+    int	 hash(const File* file, const int pageNo);
+    compEntry* find(const File* file, const int pageNo);
+    void unlinkEntry(compEntry* entry); // remove from all lists, free it
+
+public:
+    CompTier(const long budgetBytes);
+    ~CompTier();
+
+    // store a compressed copy of a clean page. Returns OK if the page was
+    // stored, NOSPACE if it did not compress enough to be worth keeping
+    Status insert(File* file, const int pageNo, const Page* page);
+
+    // if (file,pageNo) is in the tier, decompress it into page, remove it
+    // from the tier and return OK. Else return HASHNOTFOUND
+    Status lookup(const File* file, const int pageNo, Page* page);
+
+    // drop (file,pageNo) from the tier if it is there
+    void remove(const File* file, const int pageNo);
+
+    // drop all pages of a file from the tier
+    void removeFile(const File* file);
+
+    const CompStats & getStats() const { return stats; }
+    void clearStats() { stats.clear(); }
+    long getUsed() const { return used; }
+    long getBudget() const { return budget; }
+};
+
+// fast LZ77-style page codec used by the tier. pageCompress returns the
+// compressed length, or 0 if the output would not fit in dstCap bytes.
+// pageDecompress returns the number of bytes produced, or -1 if the
+// input is corrupted.
+int pageCompress(const char* src, const int srcLen, char* dst, const int dstCap);
+int pageDecompress(const char* src, const int srcLen, char* dst, const int dstCap);
+
+#endif
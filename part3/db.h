@@ -3,6 +3,9 @@
 
 #include <sys/types.h>
 #include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 #include "error.h"
 #include <string.h>
 using namespace std;
@@ -14,11 +17,15 @@ using namespace std;
 
 // forward class definition for db
 class DB;
+struct compEntry;
+class ZoneMap;
 
 // class definition for open files
 class File {
   friend class DB;
   friend class OpenFileHashTbl;
+  friend class BufMgr;
+  friend class CompTier;
 
  public:
 
@@ -28,11 +35,44 @@ class File {
 		  Page* pagePtr) const;       // read page from file
   const Status writePage(const int pageNo,
 		   const Page* pagePtr);      // write page to file
+  const Status readPages(const int pageNo,
+		  Page* const pages[],
+		  const int cnt) const;       // read cnt consecutive pages
+  const Status writePages(const int pageNo,
+		   const Page* const pages[],
+		   const int cnt);            // write cnt consecutive pages
   const Status getFirstPage(int& pageNo) const;     // returns pageNo of first page
+  const Status getNumPages(int& numPages) const;    // returns # pages in file,
+                                                    // including the header
+  const Status getFreePages(vector<int>& pageNos) const; // pages on the
+                                                    // free list
+
+  // used by the bulk loader: write cnt pages that are contiguous in
+  // memory, and make pages up to numPages-1 part of the file
+  const Status writeRun(const int pageNo, const Page* pages,
+			const int cnt);
+  const Status setNumPages(const int numPages, const int firstLoaded);
+
+  // used by the checkpointer: force written pages to disk, and record
+  // or return the number of the last complete checkpoint of the file
+  const Status sync();
+  const Status setCheckpoint(const int checkpointNo);
+  const Status getCheckpoint(int& checkpointNo) const;
+
+  // used by backups: hold setNumPages off while loads are frozen, and
+  // read the header page together with the page count it holds
+  void freezeLoads(const bool frozen);
+  const Status readHeader(Page* header, int& numPages) const;
+
+  // zone maps of the file, owned by the File and dropped when it is
+  // closed; getZoneMap returns NULL if attrOffset has none
+  void addZoneMap(ZoneMap* zoneMap);
+  ZoneMap* getZoneMap(const int attrOffset) const;
+  const vector<ZoneMap*> & getZoneMaps() const { return zoneMaps; }
 
   bool operator == (const File & other) const
     {
-      return fileName == other.fileName;
+      return fileId == other.fileId;
     }
 
  private: 
@@ -40,34 +80,86 @@ class File {
   File(const string &fname);                   // initialize
   ~File();                  // deallocate file object
 
-  static const Status create(const string &fileName);
+  static const Status create(const string &fileName,
+			     const bool direct = false);
   static const Status destroy(const string &fileName);
 
-  const Status open();
+  const Status open(const bool direct = false);
   const Status close();
 
+  int acquireFd() const;              // descriptor for one I/O call,
+                                      // reopened if needed
+  void releaseFd() const;             // I/O call done with descriptor
+  void fdAttach() const;              // enter the descriptor cache
+  void fdDetach() const;              // leave the descriptor cache
+  static void fdEvict(const int room); // close descriptors to make room
+  void openAttach();                  // enter the list of open files
+  void openDetach();                  // leave the list of open files
+
   const Status intread(const int pageNo,
 		 Page* pagePtr) const;        // internal file read
   const Status intwrite(const int pageNo,
 		  const Page* pagePtr);       // internal file write
+  const Status intreadv(const int pageNo,
+		  Page* const pages[],
+		  const int cnt) const;       // internal scattered read
+  const Status intwritev(const int pageNo,
+		  const Page* const pages[],
+		  const int cnt);             // internal gathered write
 
 #ifdef DEBUGFREE
   void listFree();                      // list free pages
 #endif
 
   string fileName;                    // The name of the file
+  int fileId;                         // interned id of fileName while
+                                      // the file is open, -1 otherwise
   int openCnt;                        // # times file has been opened
-  int unixFile;                       // unix file stream for file
+  mutable int unixFile;               // unix file stream for file, -1
+                                      // while closed by the fd cache
+  mutable int fdUsers;                // I/O calls using unixFile
+  mutable File* fdPrev;               // more recently used open file
+  mutable File* fdNext;               // less recently used open file
+  static int maxFds;                  // max descriptors kept open
+  static int numFds;                  // descriptors currently open
+  static File* fdHead;                // most recently used open file
+  static File* fdTail;                // least recently used open file
+  File* openPrev;                     // neighbours in the list of
+  File* openNext;                     // open files
+  static File* openHead;              // most recently opened file
+  static mutex fdLatch;               // protects the descriptor cache
+                                      // and the list of open files
+  bool directIO;                      // true if unixFile bypasses the
+                                      // OS page cache (O_DIRECT)
+  int firstFrame;                     // first buffer frame holding a page
+                                      // of this file, -1 if none
+  compEntry* tierPages;               // pages of this file held in the
+                                      // compressed tier, if any
+  vector<ZoneMap*> zoneMaps;          // attribute summaries for scans
+  mutable mutex headerLock;           // serializes read-modify-writes
+                                      // of the header page
+  bool loadsFrozen;                   // setNumPages must wait, under
+  condition_variable loadsThawed;     // headerLock
 };
 
 class BufMgr;
 extern BufMgr* bufMgr;
 
-// declarations for hash table of open files
+// allocate and free page buffers suitably aligned for direct I/O
+Page* allocPages(const int cnt);
+void freePages(Page* pages);
+
+// declarations for hash table of open files. File names are interned:
+// each name gets a small integer id the first time it is opened, and
+// the open files are kept in a vector indexed by id. Closing a file
+// only clears its slot, so no name is hashed on close and reopening a
+// file allocates nothing. Names stay interned until the file is
+// destroyed, which hands the id on to the next new name.
 struct fileHashBucket
 {
 	string	fname;    // name of the file
-        File*   file;    // pointer to file object
+	unsigned int	hval;     // hash value of fname
+	int	fileId;   // interned id of fname
 	fileHashBucket* next;	 // next node in the hash table
 	
 };
@@ -77,23 +169,34 @@ class OpenFileHashTbl
 {
 private:
     int HTSIZE;
+    int numEntries;       // number of interned names in the table
     fileHashBucket**  ht; // actual hash table
-    int	 hash(string fileName);  // returns value between 0 and HTSIZE-1
+    vector<File*> files;  // open file of each id, NULL if closed
+    vector<int> nextFreeId; // chains the ids of forgotten names
+    int freeIds;          // first reusable id, -1 if none
+    unsigned int hash(const string & fileName); // full hash value, the
+                                                // bucket is hash % HTSIZE
+    void grow();          // double the table size
+    fileHashBucket* lookup(const string & fileName, unsigned int & hval);
 
 public:
     OpenFileHashTbl();
     ~OpenFileHashTbl(); // destructor
 	
     // returns OK if no error occured, HASHTBLERROR if an error occurred
-    Status insert(const string fileName, File* file);
+    Status insert(const string & fileName, File* file);
 
     // see if fileName is already in hash table.  If so a pointer to the file
     // object is returned.
     // returns OK if found. else returns HASHNOTFOUND
-    Status find(const string fileName, File*& file);
+    Status find(const string & fileName, File*& file);
+
+    // returns OK if file was in the table.  Else return HASHTBLERROR
+    Status erase(File* file);
 
-    // returns OK if fileName was found.  Else return HASHTBLERROR
-    Status erase(const string fileName);
+    // drop the name of a destroyed file; returns HASHTBLERROR if the
+    // name is unknown or the file is open
+    Status forget(const string & fileName);
 };
 
 
@@ -107,19 +210,46 @@ class DB {
   const Status destroyFile(const string & fileName) ; // destroy a file, 
                                                            // release all space
   const Status openFile(const string & fileName, File* & file);  // open a file
-  const Status closeFile(File* file);         // close a file
+  const Status openFile(const string & fileName, File* & file,
+			const bool direct);   // open a file, choosing
+                                              // direct or buffered I/O
+  const Status closeFile(File* file);         // close a file; if its
+                                              // pages cannot be flushed
+                                              // (PAGEPINNED) it stays open
+
+  // keep at most maxFds unix file descriptors open across all files
+  void setMaxOpenFds(const int maxFds);
+
+  // files created or opened from now on use direct I/O if possible
+  void setDirectIO(const bool direct) { directIO = direct; }
 
  private:
   OpenFileHashTbl   openFiles;    // list of open files
+  bool              directIO;     // default I/O mode for new files
 };
 
 
+// required alignment of buffers, offsets and lengths for direct I/O;
+// PAGESIZE is a multiple of it, so page-aligned transfers qualify
+
+const int DIRECTIO_ALIGN = 512;
+
+// default limit on the number of unix file descriptors kept open
+
+const int MAXOPENFDS = 256;
+
+// maximum number of pages transferred by one coalesced read or write
+
+const int MAXIOPAGES = 64;
+
 // structure of DB (header) page
 
 typedef struct {
   int nextFree;                         // page # of next page on free list
   int firstPage;                        // page # of first page in file
   int numPages;                         // total # of pages in file
+  int checkpointNo;                     // last checkpoint that wrote all
+                                        // pages of the file, 0 if none
 } DBPage;
 
 #endif
@@ -0,0 +1,178 @@
+#ifndef FIXEDPAGE_H
+#define FIXEDPAGE_H
+
+#include <bit>
+#include <iostream>
+#include "page.h"
+using namespace std;
+
+const unsigned FIXEDFIXED = 4*sizeof(int);
+const unsigned FIXEDDATASIZE = PAGESIZE - FIXEDFIXED;
+// size of the bitmap and record area of a fixed page
+
+// number of records of recLen bytes that fit on a fixed page next to
+// their presence bitmap
+constexpr int fixedCapacity(const int recLen)
+{
+    int cap = recLen > 0 ? (FIXEDDATASIZE * 8) / (recLen * 8 + 1) : 0;
+    while (cap > 0 && ((cap + 63) / 64) * 8 + cap * recLen > (int) FIXEDDATASIZE)
+	cap--;
+    return cap;
+}
+
+// Class definition for a data page of fixed-length records.
+// The record length is a template parameter, so a FixedPage needs no
+// slot array: record slotNo is at offset slotNo * RecordSize, and a
+// bitmap with one bit per slot tells which slots hold a record. An
+// insert takes the first zero bit, a delete clears the record's bit;
+// no bytes are moved and RIDs stay stable. Iteration jumps from record
+// to record by counting trailing zero bits, a word at a time.
+//
+// A FixedPage has the same size as a Page, so a buffer frame can hold
+// either one, and has the same firstRecord / nextRecord / getRecord
+// interface. Slot numbers of RIDs count from 0.
+
+template <int RecordSize>
+class FixedPage {
+public:
+    static const int CAPACITY = fixedCapacity(RecordSize); // records per page
+    static_assert(CAPACITY > 0, "the record does not fit on a page");
+
+private:
+    static const int WORDS = (CAPACITY + 63) / 64;  // bitmap words
+
+    unsigned long long bitmap[WORDS];  // bit i set if slot i holds a record
+    char	recs[FIXEDDATASIZE - WORDS * sizeof(unsigned long long)];
+    int		freeWord; // no free slot in the bitmap words before this one
+    int		dummy;	  // for alignment purposes
+    int		nextPage; // forwards pointer
+    int		curPage;  // page number of current pointer
+
+    bool inUse(const int slotNo) const
+    {
+	return (bitmap[slotNo >> 6] >> (slotNo & 63)) & 1;
+    }
+
+public:
+    void init(const int pageNo)  // initialize a new page
+    {
+	// here, where the class is complete; every user of a page calls init
+	static_assert(sizeof(FixedPage) == sizeof(Page),
+		      "a FixedPage must fit exactly in a buffer frame");
+	memset(bitmap, 0, sizeof bitmap);
+	freeWord = 0;
+	nextPage = -1;
+	curPage = pageNo;
+    }
+
+    void dumpPage() const        // dump contents of a page
+    {
+	cout << "curPage = " << curPage << ", nextPage = " << nextPage
+	     << "\nrecLen = " << RecordSize << ", capacity = " << CAPACITY
+	     << ", recCnt = " << getRecCnt() << endl;
+    }
+
+    const Status getNextPage(int& pageNo) const // returns value of nextPage
+    {
+	pageNo = nextPage;
+	return OK;
+    }
+    const Status setNextPage(const int pageNo) // sets value of nextPage to pageNo
+    {
+	nextPage = pageNo;
+	return OK;
+    }
+
+    const int getRecCnt() const
+    {
+	int cnt = 0;
+	for (int w = 0; w < WORDS; w++)
+	    cnt += popcount(bitmap[w]);
+	return cnt;
+    }
+    const int getFreeSlots() const { return CAPACITY - getRecCnt(); }
+    bool isValid(const int slotNo) const
+    {
+	return slotNo >= 0 && slotNo < CAPACITY && inUse(slotNo);
+    }
+
+    // inserts a new record (rec) into the lowest free slot, returns RID
+    // of record. returns NOSPACE if the page is full, INVALIDRECLEN if
+    // the record is not RecordSize bytes long
+    const Status insertRecord(const Record & rec, RID& rid)
+    {
+	if (rec.length != RecordSize) return INVALIDRECLEN;
+
+	int w = freeWord;
+	while (w < WORDS && bitmap[w] == ~0ULL)
+	    w++;
+	freeWord = w;
+	if (w == WORDS) return NOSPACE;
+	int slotNo = w * 64 + countr_one(bitmap[w]);
+	if (slotNo >= CAPACITY) return NOSPACE; // past the end of the last word
+
+	memcpy(&recs[slotNo * RecordSize], rec.data, RecordSize);
+	bitmap[w] |= 1ULL << (slotNo & 63);
+
+	rid.pageNo = curPage;
+	rid.slotNo = slotNo;
+	return OK;
+    }
+
+    // delete the record with the specified rid
+    const Status deleteRecord(const RID & rid)
+    {
+	int slotNo = rid.slotNo;
+
+	if (!isValid(slotNo)) return INVALIDSLOTNO;
+	bitmap[slotNo >> 6] &= ~(1ULL << (slotNo & 63));
+	if ((slotNo >> 6) < freeWord)
+	    freeWord = slotNo >> 6;
+	return OK;
+    }
+
+    // returns RID of first record on page
+    // returns  NORECORDS if page contains no records.  Otherwise, returns OK
+    const Status firstRecord(RID& firstRid) const
+    {
+	RID tmpRid;
+
+	tmpRid.pageNo = curPage;
+	tmpRid.slotNo = -1;
+	if (nextRecord(tmpRid, firstRid) != OK) return NORECORDS;
+	return OK;
+    }
+
+    // returns RID of next record on the page
+    // returns ENDOFPAGE if no more records exist on the page
+    const Status nextRecord (const RID & curRid, RID& nextRid) const
+    {
+	int i = curRid.slotNo + 1;
+	if (i < 0 || i >= CAPACITY) return ENDOFPAGE;
+
+	// the bits of the current word from slot i on, then whole words
+	int w = i >> 6;
+	unsigned long long bits = bitmap[w] & (~0ULL << (i & 63));
+	while (bits == 0)
+	{
+	    if (++w == WORDS) return ENDOFPAGE;
+	    bits = bitmap[w];
+	}
+
+	nextRid.pageNo = curPage;
+	nextRid.slotNo = w * 64 + countr_zero(bits);
+	return OK;
+    }
+
+    // returns reference to record with RID rid
+    const Status getRecord(const RID & rid, Record & rec)
+    {
+	if (!isValid(rid.slotNo)) return INVALIDSLOTNO;
+
+	rec.data = &recs[rid.slotNo * RecordSize];
+	rec.length = RecordSize;
+	return OK;
+    }
+};
+
+#endif
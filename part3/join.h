@@ -0,0 +1,80 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include <mutex>
+#include <vector>
+#include "page.h"
+#include "db.h"
+#include "query.h"
+#include "bulkLoad.h"
+
+// number of in-memory partitions of the build side; each has its own
+// hash table, so tables stay small and are built in parallel
+const int JOINPARTS = 64;
+
+// most partitions a join spills its inputs into
+const int MAXSPILLPARTS = 64;
+
+// Parallel equi-join of two heap files. The left file is the build
+// side: its records are copied into per-thread arenas, split into
+// JOINPARTS partitions by hash value, and each partition gets an open
+// addressing hash table of (hash, record) entries. The right file is
+// then scanned in parallel and probes those tables.
+//
+// If the left file does not fit in the memory grant, both inputs are
+// first partitioned by hash value into temporary files (Grace hash
+// join), and the pairs of partitions are joined one at a time. The
+// partition pages are written through the buffer pool, one pinned frame
+// at a time, so spilling takes no memory beyond a page image per
+// partition. The build counts the bytes its records and hash tables
+// take, so a left input that outgrows the grant although its file
+// looked small enough is partitioned too, and so is a partition that
+// outgrows it. After two levels of partitioning, a partition that is
+// still larger than the grant is joined in memory anyway.
+//
+// Every matching pair produces one record in the result file: the left
+// record followed by the right record.
+
+class HashJoin {
+ public:
+  HashJoin(DB & db, const int numThreads, const long memGrant);
+
+  // joins left and right on leftAttr = rightAttr into a new file
+  // resultName, which is closed again when the join is done and
+  // destroyed if it fails.
+  // Returns ATTRTYPEMISMATCH if the attributes cannot be compared,
+  // ATTRTOOLONG if a matching pair is too long for a page of the result
+  // and TMP_RES_EXISTS if the result or a spill file exists already
+  const Status join(File* left, const AttrDesc & leftAttr,
+		    File* right, const AttrDesc & rightAttr,
+		    const string & resultName, int & resultCnt);
+
+  int getSpillParts() const { return spillParts; } // partitions of all
+                                                   // levels, 0 if joined
+                                                   // in memory
+
+ private:
+  friend class JoinBuildWorker;
+  friend class JoinProbeWorker;
+  friend class JoinSpillWorker;
+
+  const Status joinFiles(File* left, File* right, const string & prefix,
+		       const int level);
+  const Status joinInMemory(File* left, File* right, const long maxBytes,
+			    bool & overflowed);
+  const Status spill(File* input, const AttrDesc & attr, const string & prefix,
+		     const int parts, const int level, vector<File*> & files);
+  const Status emit(const char* buf, const int len); // flush output records
+
+  DB &	   db;
+  int	   numThreads;
+  long	   memGrant;      // bytes the build side may use
+  AttrDesc leftAttr;
+  AttrDesc rightAttr;
+  int	   spillParts;
+  BulkLoader* out;        // writes the result file
+  mutex	   outLock;       // protects out and outCnt
+  int	   outCnt;        // records written to the result
+};
+
+#endif
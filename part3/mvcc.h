@@ -0,0 +1,168 @@
+#ifndef MVCC_H
+#define MVCC_H
+
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "page.h"
+#include "db.h"
+
+typedef unsigned long Timestamp;
+
+// end timestamp of a version that has not been replaced or deleted
+const Timestamp MAXTS = ~0UL;
+
+// number of lock stripes; pages are spread over them by hash value
+const int MVCCSTRIPES = 64;
+
+// Every record of a file managed by a VersionStore starts with this
+// header; the caller's data follows it. The version on the page is the
+// newest one; it is visible to snapshots in [beginTs, endTs).
+struct VersionHdr
+{
+  Timestamp beginTs;   // commit time of the insert or update
+  Timestamp endTs;     // commit time of the delete, MAXTS if none
+};
+
+// Receives the records of a page that are visible in a snapshot. data
+// is a private copy of the record without its header, valid during the
+// call only.
+class MvccVisitor
+{
+ public:
+  virtual ~MvccVisitor() {}
+  virtual const Status visit(const RID & rid, const char* data,
+			     const int len) = 0;
+};
+
+// Multi-version records on heap file pages.
+//
+// Writers insert, update and delete records through the store; each
+// operation commits on its own at a new timestamp. An update copies the
+// old version into the undo area, a chain of older versions per record
+// kept in memory, and overwrites the record on the page; a delete only
+// sets the end timestamp of the record on the page. Updates keep the
+// record's length and RID.
+//
+// Readers take a snapshot, a timestamp, and see every record as of that
+// time: the version on the page if it is old enough, otherwise the
+// version from the undo chain. Records are copied out under a shared
+// lock of the page's stripe, so a scan never holds a lock, or a pin,
+// that keeps writers out for longer than one page copy.
+//
+// Versions that no snapshot can see any more are dropped by collect(),
+// which can also run in a background thread: old versions are freed
+// and deleted records are removed from their pages.
+//
+// A file must be attached before its records are used through the
+// store and detached before it is closed. All records of an attached
+// file must be written through the store.
+
+class VersionStore {
+ public:
+  VersionStore();
+  ~VersionStore();                      // stops the collector
+
+  const Status attach(File* file);      // start managing file's records
+  void detach(const File* file);        // forget file's old versions
+
+  Timestamp beginSnapshot();            // a snapshot of everything
+                                        // committed so far
+  void endSnapshot(const Timestamp snapshot);
+
+  const Status insert(File* file, const Record & rec, RID & rid);
+  // INVALIDRECLEN if the length changes, RECNOTFOUND if deleted
+  const Status update(File* file, const RID & rid, const Record & rec);
+  const Status remove(File* file, const RID & rid);
+
+  // copies the version of rid visible in snapshot to buf (PAGESIZE
+  // bytes); RECNOTFOUND if there is none
+  const Status read(File* file, const RID & rid, const Timestamp snapshot,
+		    char* buf, int & len);
+  // calls visitor for every record of page (pinned by the caller) that
+  // is visible in snapshot
+  const Status scanPage(File* file, const int pageNo, Page* page,
+			const Timestamp snapshot, MvccVisitor & visitor);
+
+  int collect();            // drops invisible versions, returns how many
+  void startCollector(const int intervalMs);
+  void stopCollector();
+
+  int getVersionCnt();      // old versions in the undo area
+
+ private:
+  struct Version            // an old version in the undo area
+  {
+    Timestamp beginTs;
+    Timestamp endTs;
+    Version*  older;
+    int	      len;
+    char      data[1];      // len bytes
+  };
+
+  struct VersionKey
+  {
+    const File* file;
+    int	pageNo;
+    int	slotNo;
+    bool operator == (const VersionKey & other) const
+      {
+	return file == other.file && pageNo == other.pageNo
+	  && slotNo == other.slotNo;
+      }
+  };
+
+  struct KeyHash
+  {
+    size_t operator () (const VersionKey & key) const
+      {
+	return (size_t) key.file * 31 + key.pageNo * 17 + key.slotNo;
+      }
+  };
+
+  struct Tombstone          // a deleted record still on its page
+  {
+    File*     file;
+    RID	      rid;
+    Timestamp endTs;
+  };
+
+  struct Stripe
+  {
+    shared_mutex lock;      // shared to copy records, exclusive to change
+    unordered_map<VersionKey, Version*, KeyHash> chains; // newest first
+    vector<Tombstone> tombstones;
+    int	versionCnt;
+  };
+
+  Stripe & stripeOf(const File* file, const int pageNo);
+  bool visibleCopy(const File* file, const int pageNo, const RID & rid,
+		   const char* rec, const int recLen, const Timestamp snapshot,
+		   Stripe & stripe, const char*& data, int & len);
+  const Status insertOn(File* file, const int pageNo, const Record & rec,
+			RID & rid, const Timestamp ts);
+  void freeChain(Version* version);
+  void collectLoop(const int intervalMs);
+
+  Stripe    stripes[MVCCSTRIPES];
+  atomic<Timestamp> clock;  // last commit timestamp
+  shared_mutex commitLock;  // shared by writers while they commit,
+                            // exclusive to take a snapshot
+  mutex	    snapLock;       // protects snapshots
+  multiset<Timestamp> snapshots;  // active snapshots
+  mutex	    insertLock;     // protects lastPages, serializes inserts
+  map<const File*, int> lastPages; // last page of each attached file
+
+  thread*   collector;      // background collector, or NULL
+  mutex	    collectLock;    // protects stopping
+  condition_variable collectWake;
+  bool	    stopping;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef PAXPAGE_H
+#define PAXPAGE_H
+
+#include "page.h"
+
+// maximum number of attributes of a PAX page schema
+const int MAXPAXATTRS = 16;
+
+const unsigned PAXFIXED = 6*sizeof(short) + 2*MAXPAXATTRS*sizeof(short)
+                          + 2*sizeof(int);
+const unsigned PAXDATASIZE = PAGESIZE - PAXFIXED;
+// size of the data area of a PAX page
+
+// Class definition for a PAX (partition attributes across) data page.
+// A PAX page holds records of one fixed schema. Instead of storing the
+// records one after the other like Page does, the values of each
+// attribute are grouped together in their own minipage, so that a scan
+// over one attribute only touches that attribute's bytes. A presence
+// bitmap tells which record slots are in use. Deleting a record just
+// clears its bit; nothing is shifted and RIDs stay stable.
+//
+// A PaxPage has the same size as a Page, so a buffer frame can hold
+// either one. Records are passed in and out in their usual row format,
+// i.e. the attribute values concatenated in schema order.
+
+class PaxPage {
+private:
+    char	data[PAXDATASIZE]; // presence bitmap, then the minipages
+    short	attrCnt;  // number of attributes
+    short	recLen;   // length of a record (sum of attribute lengths)
+    short	capacity; // maximum number of records on the page
+    short	slotCnt;  // number of slots ever used (high water mark)
+    short	recCnt;   // number of records on the page
+    short	dummy;    // for alignment purposes
+    short	attrLen[MAXPAXATTRS]; // length of each attribute
+    short	attrOff[MAXPAXATTRS]; // offset of each minipage in data[]
+    int		nextPage; // forwards pointer
+    int		curPage;  // page number of current pointer
+
+    bool inUse(const int slotNo) const
+    {
+	return (data[slotNo >> 3] >> (slotNo & 7)) & 1;
+    }
+
+public:
+    // initialize a new page for records with attributes of the given
+    // lengths. Returns INVALIDRECLEN if the schema does not fit.
+    const Status init(const int pageNo, const int attrs, const int lengths[]);
+    void dumpPage() const;       // dump contents of a page
+
+    const Status getNextPage(int& pageNo) const; // returns value of nextPage
+    const Status setNextPage(const int pageNo); // sets value of nextPage to pageNo
+    const int getFreeSlots() const { return capacity - recCnt; }
+    const int getRecLen() const { return recLen; }
+
+    // inserts a new record (rec) into the page, returns RID of record.
+    // returns NOSPACE if the page is full, INVALIDRECLEN if the record
+    // does not have the schema's length
+    const Status insertRecord(const Record & rec, RID& rid);
+
+    // delete the record with the specified rid
+    const Status deleteRecord(const RID & rid);
+
+    // returns RID of first record on page
+    // returns  NORECORDS if page contains no records.  Otherwise, returns OK
+    const Status firstRecord(RID& firstRid) const;
+
+    // returns RID of next record on the page
+    // returns ENDOFPAGE if no more records exist on the page
+    const Status nextRecord (const RID & curRid, RID& nextRid) const;
+
+    // copies the record with RID rid into rec.data, which must have room
+    // for getRecLen() bytes, and sets rec.length. Unlike Page::getRecord
+    // the record is assembled from the minipages, so it is a copy.
+    const Status getRecord(const RID & rid, Record & rec) const;
+
+    // returns pointer to one attribute value of the record with RID rid
+    const Status getAttr(const RID & rid, const int attrNo, const char*& value) const;
+
+    // column-at-a-time access: the values of attribute attrNo for slots
+    // 0 .. getSlotCnt()-1 are stored back to back, attrLen bytes each.
+    // Only slots with isValid(slotNo) hold records.
+    const char* getColumn(const int attrNo) const { return &data[attrOff[attrNo]]; }
+    const int getSlotCnt() const { return slotCnt; }
+    const int getRecCnt() const { return recCnt; }
+    bool isValid(const int slotNo) const
+    {
+	return slotNo >= 0 && slotNo < slotCnt && inUse(slotNo);
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+using namespace std;
+
+// Hot paths that can be profiled
+enum ProfilePoint {
+  PROF_HASHLOOKUP,      // BufHashTbl::lookup
+  PROF_ALLOCBUF,        // BufMgr::allocBuf
+  PROF_DELETERECORD,    // Page::deleteRecord
+  PROFPOINTS
+};
+
+// Hardware events counted for each profiled call
+enum ProfileEvent {
+  PROF_CYCLES,
+  PROF_INSTRUCTIONS,
+  PROF_L1DMISSES,       // L1 data cache read misses
+  PROF_LLCMISSES,       // last level cache misses
+  PROF_BRANCHMISSES,
+  PROF_DTLBMISSES,      // data TLB read misses
+  PROFEVENTS
+};
+
+// Profiling of selected hot paths with hardware performance counters.
+//
+// A ProfileScope measures the code from its construction to the end of
+// its scope: the elapsed time and, through perf_event_open, the events
+// above counted in user mode on the calling thread. Each thread opens
+// its counters on its first profiled call. Where perf events are not
+// allowed (perf_event_paranoid, containers) or an event is not
+// supported by the CPU, only the time, or the events that could be
+// opened, are recorded.
+//
+// The hot paths are instrumented with PROFILE_SCOPE, which is compiled
+// in only when PROFILE is defined, e.g.
+//
+//   make CXXFLAGS="-g -Wall -pthread -std=c++20 -DPROFILE"
+//
+// and "benchbuf profile" of such a build prints the report of a
+// workload that runs through all of them.
+//
+// Reading the counters takes a system call at both ends of a scope, so
+// the times of a profiling build are much larger than those of a normal
+// one; the event counts exclude the kernel.
+
+class ProfileScope {
+ public:
+  ProfileScope(const ProfilePoint profPoint);
+  ~ProfileScope();
+
+ private:
+  ProfilePoint point;
+  bool counting;                    // counters were read at the start
+  unsigned long start[PROFEVENTS];
+  chrono::steady_clock::time_point startTime;
+};
+
+#ifdef PROFILE
+#define PROFILE_SCOPE(point) ProfileScope profileScope(point)
+#else
+#define PROFILE_SCOPE(point)
+#endif
+
+struct ProfileStats
+{
+  unsigned long calls;      // profiled calls
+  unsigned long nanos;      // total time of the calls
+  unsigned long counted;    // calls with hardware counters
+  unsigned long events[PROFEVENTS]; // totals over the counted calls
+  bool eventValid[PROFEVENTS];      // event was counted on some thread
+};
+
+void profileClear();                // reset all totals
+const ProfileStats profileStats(const ProfilePoint point);
+bool profileCounting();             // can this thread count events?
+
+// prints the per-call averages of every point that was called
+void profileReport(ostream & os);
+
+#endif
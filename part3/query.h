@@ -0,0 +1,51 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "page.h"
+#include "db.h"
+
+// Definitions shared by the query operators (join, aggregation) that
+// run on records of heap files. Records are untyped byte strings; an
+// operator is told where its attributes are through AttrDesc.
+
+enum Datatype { STRING, INTEGER, FLOAT };
+
+enum Operator { LT, LTE, EQ, GTE, GT, NE };
+
+// location and type of one fixed-offset attribute within a record
+struct AttrDesc
+{
+  int      offset;   // byte offset within the record
+  int      length;   // length in bytes; sizeof(int)/sizeof(float) for numbers
+  Datatype type;
+};
+
+// OK if attr fits within records of length recLen, BADRECPTR otherwise
+const Status checkAttr(const AttrDesc & attr, const int recLen);
+
+// ATTRTYPEMISMATCH unless the two attributes can be compared
+const Status matchAttrs(const AttrDesc & a, const AttrDesc & b);
+
+// hash of an attribute value; values that compare equal hash equally
+unsigned int hashAttr(const char* rec, const AttrDesc & attr);
+
+// compares attribute values of two records: < 0, 0 or > 0
+int compareAttr(const char* a, const AttrDesc & aAttr,
+		const char* b, const AttrDesc & bAttr);
+
+// compares the attribute of rec with value, a value of the attribute's
+// type and length: < 0, 0 or > 0
+int compareValue(const char* rec, const AttrDesc & attr, const char* value);
+
+// true if the attribute of rec satisfies attr op value
+bool evalPredicate(const char* rec, const AttrDesc & attr,
+		   const Operator op, const char* value);
+
+// creates and opens a temporary file for an operator. Returns
+// TMP_RES_EXISTS if a file by that name exists already
+const Status createTempFile(DB & db, const string & fileName, File*& file);
+
+// closes and removes a temporary file
+const Status destroyTempFile(DB & db, const string & fileName, File* file);
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include "page.h"
+#include "buf.h"
+#include "query.h"
+
+class ZoneMap;
+
+// default number of pages in a morsel, the unit of work of a scan
+const int MORSELPAGES = 16;
+
+// A range of pages [first, last) of a file handed to a scan worker.
+struct Morsel
+{
+  int first;
+  int last;
+};
+
+// The per-page work of a parallel scan. processPage is called once for
+// every user page of the file, from several threads at a time; threadNo
+// (0 .. number of threads - 1) identifies the calling thread, so that
+// each thread can keep its own partial results and the caller can
+// merge them after ParallelScan::run returns. The page is pinned while
+// processPage runs and must not be unpinned by it.
+class ScanWorker
+{
+ public:
+  virtual ~ScanWorker() {}
+  virtual const Status processPage(const int threadNo, const int pageNo,
+				   Page* page) = 0;
+
+  // asked before a page is read; a worker with a predicate returns
+  // false for pages that cannot match (see ZoneMap), which are then
+  // skipped without being read or pinned
+  virtual bool wantPage(const int pageNo) { return true; }
+};
+
+// Parallel scan over all user pages of a file. The page range of the
+// file (pages 1 .. numPages-1, minus the free list) is cut into morsels
+// that are dealt out round robin to the threads' work queues. A thread
+// takes morsels from the front of its own queue and, once that is
+// empty, steals from the back of the other threads' queues. Pages are
+// read through the buffer pool, a morsel at a time.
+//
+// A scan with a filter skips the pages that the file's zone map on the
+// filter attribute rules out, without reading them. The worker still
+// sees every record of the pages it gets and has to apply the
+// predicate itself.
+
+class ParallelScan
+{
+ public:
+  ParallelScan(File* file, const int numThreads,
+	       const int morselPages = MORSELPAGES);
+
+  // runs worker over all pages of the file and waits for all threads.
+  // Returns OK or the first error of any thread; the other threads stop
+  // at their next morsel after an error
+  const Status run(ScanWorker & worker);
+
+  // skip pages with no record satisfying attr op value, if the file has
+  // a zone map on attr; value is copied
+  void setFilter(const AttrDesc & attr, const Operator op, const char* value);
+
+  int getThreadCnt() const { return numThreads; }
+  int getSteals() const { return steals; }  // morsels taken from other threads
+  int getSkipped() const { return skipped; } // pages skipped by the filter
+                                             // or the worker
+
+ private:
+  struct WorkQueue
+  {
+    mutex lock;
+    deque<Morsel> morsels;
+  };
+
+  bool nextMorsel(const int threadNo, Morsel & morsel);
+  void work(const int threadNo, ScanWorker & worker);
+  const Status scanMorsel(const int threadNo, const Morsel & morsel,
+			  ScanWorker & worker);
+
+  File*	file;
+  int	numThreads;
+  int	morselPages;
+  vector<bool> isFree;      // free list pages, never handed to workers
+  bool	hasFilter;
+  AttrDesc filterAttr;
+  Operator filterOp;
+  vector<char> filterValue;
+  ZoneMap* zoneMap;         // of the file on filterAttr, NULL if none
+  vector<WorkQueue*> queues; // one queue per thread
+  mutex	statusLock;          // protects firstError, steals and skipped
+  Status firstError;
+  int	steals;
+  int	skipped;
+};
+
+#endif
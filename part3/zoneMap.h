@@ -0,0 +1,62 @@
+#ifndef ZONEMAP_H
+#define ZONEMAP_H
+
+#include <mutex>
+#include <vector>
+#include "page.h"
+#include "db.h"
+#include "query.h"
+
+// A zone map summarizes one attribute of the records of a file: for
+// every zone (a range of zonePages pages, one page by default) it keeps
+// the number of records and the smallest and largest attribute value.
+// A scan with a predicate on the attribute asks mayMatch() before it
+// reads a page and skips zones that cannot hold a matching record;
+// ParallelScan::setFilter does so with the file's zone map.
+//
+// Zone maps live in memory with the File they are attached to (see
+// File::addZoneMap) and are dropped when the file is closed; build()
+// summarizes a file that already holds records. Code that inserts or
+// deletes records on the file's pages must report them through
+// addRecord() and deleteRecord(); the bulk loader does so for the
+// records it loads, and File::disposePage forgets a disposed page.
+//
+// Deleting records does not narrow a zone's range, so it may be wider
+// than needed, but it is never too narrow. A zone matches as long as
+// one of its pages was never summarized, e.g. a page that was written
+// before the map was attached.
+
+class ZoneMap {
+ public:
+  ZoneMap(const AttrDesc & attr, const int zonePages = 1);
+
+  void addRecord(const int pageNo, const char* rec);  // rec was inserted
+  void deleteRecord(const int pageNo);                // a record was deleted
+  void dropPage(const int pageNo);                    // page was disposed
+
+  // false if no record on pageNo can satisfy attr op value
+  bool mayMatch(const int pageNo, const Operator op, const char* value) const;
+
+  // summarizes all records of file, replacing what was kept before
+  const Status build(File* file);
+
+  const AttrDesc & getAttr() const { return attr; }
+  int getZonePages() const { return zonePages; }
+
+ private:
+  friend class ZoneBuildWorker;
+
+  void addZone(const int zone);       // make room up to zone
+  void addLocked(const int pageNo, const char* rec);
+
+  AttrDesc attr;
+  AttrDesc valueAttr;       // attr at offset 0, for the kept values
+  int	   zonePages;
+  vector<int> pageCnts;     // records per page, -1 if never summarized
+  vector<int> zoneCnts;     // records per zone, -1 if never summarized
+  vector<char> minValues;   // attr.length bytes per zone
+  vector<char> maxValues;
+  mutable mutex lock;       // protects all of the above
+};
+
+#endif